@@ -4,6 +4,23 @@
 #include <deque>     // 用于 std::deque
 #include <iomanip>   // 用于格式化输出
 #include <sstream>   // 用于字符串流
+#include <string>    // 用于 std::string
+#include <list>      // 用于 std::list
+#include <unordered_map> // 用于 std::unordered_map
+#include <unordered_set> // 用于 std::unordered_set
+#include <memory>    // 用于 std::shared_ptr
+#include <thread>    // 用于 std::thread
+#include <mutex>     // 用于 std::mutex
+#include <condition_variable> // 用于 std::condition_variable
+#include <cstdio>    // 用于 fopen/fread
+#include <cstdint>   // 用于 int32_t
+#include <climits>   // 用于 INT_MAX
+#ifndef _WIN32
+#include <fcntl.h>   // 用于 open
+#include <sys/mman.h> // 用于 mmap
+#include <sys/stat.h> // 用于 fstat
+#include <unistd.h>  // 用于 close
+#endif
 
 
 using namespace std;
@@ -89,7 +106,535 @@ void lruPageReplacement(const vector<int>& pages, int frameCount) {
     cout << "\nTotal page faults: " << pageFaults << ", Page fault rate: " << fixed << setprecision(2) << (faultRate * 100) << "%\n";
 }
 
-int main() {
+// ==================== 流式模式 ====================
+// 页面序列按固定大小的块读入，由读取线程经有界队列分发给多个模拟线程，
+// 每个线程运行一组 (算法, 参数)，内存占用与序列长度无关。
+
+using Chunk = shared_ptr<const vector<int>>;
+
+// 有界阻塞队列：队列满时生产者等待，队列空时消费者等待
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : capacity(capacity) {}
+
+    void push(Chunk chunk) {
+        unique_lock<mutex> lock(mtx);
+        notFull.wait(lock, [this] { return items.size() < capacity; });
+        items.push_back(move(chunk));
+        notEmpty.notify_one();
+    }
+
+    // 读取结束后放入空指针，通知消费者退出
+    void close() { push(nullptr); }
+
+    Chunk pop() {
+        unique_lock<mutex> lock(mtx);
+        notEmpty.wait(lock, [this] { return !items.empty(); });
+        Chunk chunk = items.front();
+        items.pop_front();
+        notFull.notify_one();
+        return chunk;
+    }
+
+private:
+    size_t capacity;
+    deque<Chunk> items;
+    mutex mtx;
+    condition_variable notFull, notEmpty;
+};
+
+// 增量式页面置换模拟器：每次访问一个页面，返回是否缺页
+class PageSimulator {
+public:
+    virtual ~PageSimulator() = default;
+    virtual bool access(int page) = 0;
+    // 当前驻留集大小（内存中的页面数）
+    virtual size_t residentSize() const = 0;
+};
+
+// FIFO：队列记录装入顺序，哈希表判断页面是否在内存中
+class FifoSimulator : public PageSimulator {
+public:
+    explicit FifoSimulator(int frameCount) : frameCount(frameCount) {}
+
+    bool access(int page) override {
+        if (resident.count(page))
+            return false;
+        if (static_cast<int>(frames.size()) == frameCount) {
+            // Evict the oldest page
+            resident.erase(frames.front());
+            frames.pop_front();
+        }
+        frames.push_back(page);
+        resident.insert(page);
+        return true;
+    }
+
+    size_t residentSize() const override { return frames.size(); }
+
+private:
+    int frameCount;
+    deque<int> frames;
+    unordered_set<int> resident;
+};
+
+// LRU：链表尾部为最近使用，哈希表保存页面在链表中的位置
+class LruSimulator : public PageSimulator {
+public:
+    explicit LruSimulator(int frameCount) : frameCount(frameCount) {}
+
+    bool access(int page) override {
+        auto it = position.find(page);
+        if (it != position.end()) {
+            // Move the used page to the back (most recently used)
+            frames.splice(frames.end(), frames, it->second);
+            return false;
+        }
+        if (static_cast<int>(frames.size()) == frameCount) {
+            // Evict the least recently used page
+            position.erase(frames.front());
+            frames.pop_front();
+        }
+        frames.push_back(page);
+        position[page] = prev(frames.end());
+        return true;
+    }
+
+    size_t residentSize() const override { return frames.size(); }
+
+private:
+    int frameCount;
+    list<int> frames;
+    unordered_map<int, list<int>::iterator> position;
+};
+
+// 工作集模型：驻留集为最近 window 次访问中引用过的页面（可变分配）
+// 滑动窗口保存最近 window 次访问，lastRef 记录每个页面最后一次被访问的时刻，
+// 窗口滑出的访问若仍是该页面的最后一次访问，则该页面离开工作集。
+class WorkingSetSimulator : public PageSimulator {
+public:
+    explicit WorkingSetSimulator(int window) : window(window) {}
+
+    bool access(int page) override {
+        // 不在工作集 W(t-1, window) 中即为缺页
+        bool fault = lastRef.find(page) == lastRef.end();
+        recent.push_back(make_pair(now, page));
+        lastRef[page] = now;
+
+        // 移出窗口 (now - window, now] 之外的访问
+        while (recent.front().first <= now - window) {
+            auto it = lastRef.find(recent.front().second);
+            if (it->second == recent.front().first)
+                lastRef.erase(it);
+            recent.pop_front();
+        }
+        now++;
+        return fault;
+    }
+
+    size_t residentSize() const override { return lastRef.size(); }
+
+private:
+    int window;
+    long long now = 0;
+    deque<pair<long long, int>> recent;
+    unordered_map<int, long long> lastRef;
+};
+
+// 缺页频率（PFF）控制：两次缺页间隔不超过 threshold 时只增加驻留页面；
+// 间隔超过 threshold 时，淘汰自上次缺页以来未被访问过的页面。
+class PffSimulator : public PageSimulator {
+public:
+    explicit PffSimulator(int threshold) : threshold(threshold) {}
+
+    bool access(int page) override {
+        auto it = lastRef.find(page);
+        if (it != lastRef.end()) {
+            it->second = now++;
+            return false;
+        }
+
+        // Page fault
+        if (now - lastFault > threshold) {
+            for (auto p = lastRef.begin(); p != lastRef.end();) {
+                if (p->second < lastFault)
+                    p = lastRef.erase(p);
+                else
+                    ++p;
+            }
+        }
+        lastFault = now;
+        lastRef[page] = now++;
+        return true;
+    }
+
+    size_t residentSize() const override { return lastRef.size(); }
+
+private:
+    int threshold;
+    long long now = 0;
+    long long lastFault = 0;
+    unordered_map<int, long long> lastRef;
+};
+
+// 一组模拟配置，如 "lru:4"、"ws:10"、"pff:5"
+struct SimConfig {
+    string policy;
+    int param; // fifo/lru 为 frameCount，ws 为窗口大小，pff 为缺页间隔阈值
+    long long references = 0;
+    long long pageFaults = 0;
+    long long residentSum = 0; // 用于计算平均驻留集大小
+    size_t residentMax = 0;
+};
+
+unique_ptr<PageSimulator> makeSimulator(const SimConfig& config) {
+    if (config.policy == "fifo")
+        return unique_ptr<PageSimulator>(new FifoSimulator(config.param));
+    if (config.policy == "lru")
+        return unique_ptr<PageSimulator>(new LruSimulator(config.param));
+    if (config.policy == "ws")
+        return unique_ptr<PageSimulator>(new WorkingSetSimulator(config.param));
+    if (config.policy == "pff")
+        return unique_ptr<PageSimulator>(new PffSimulator(config.param));
+    return nullptr;
+}
+
+const char* paramName(const SimConfig& config) {
+    if (config.policy == "ws")
+        return "window";
+    if (config.policy == "pff")
+        return "threshold";
+    return "frameCount";
+}
+
+// 严格解析 [1, maxValue] 范围内的正整数，整个字符串都必须是数字
+bool parsePositive(const string& text, long long maxValue, long long& value) {
+    if (text.empty() || text[0] < '0' || text[0] > '9')
+        return false;
+    size_t pos = 0;
+    try {
+        value = stoll(text, &pos);
+    } catch (...) {
+        return false;
+    }
+    return pos == text.size() && value > 0 && value <= maxValue;
+}
+
+// 解析 "policy:param"
+bool parseConfig(const string& spec, SimConfig& config) {
+    size_t colon = spec.find(':');
+    if (colon == string::npos)
+        return false;
+    config.policy = spec.substr(0, colon);
+    long long param;
+    if (!parsePositive(spec.substr(colon + 1), INT_MAX, param))
+        return false;
+    config.param = static_cast<int>(param);
+    return makeSimulator(config) != nullptr;
+}
+
+// 把一个块分发到所有模拟线程的队列
+void broadcast(vector<unique_ptr<BoundedQueue>>& queues, const Chunk& chunk) {
+    for (auto& q : queues)
+        q->push(chunk);
+}
+
+// 读取文本格式序列（空白分隔的整数），跨块边界的数字会被拼接；
+// 超出 int 范围的数或非法字符视为格式错误，报告其字节偏移
+bool readTextTrace(const string& path, size_t chunkSize, vector<unique_ptr<BoundedQueue>>& queues) {
+    FILE* fp = (path == "-") ? stdin : fopen(path.c_str(), "r");
+    if (!fp) {
+        cerr << "Cannot open " << path << endl;
+        return false;
+    }
+
+    vector<char> buffer(1 << 16);
+    auto chunk = make_shared<vector<int>>();
+    chunk->reserve(chunkSize);
+    long long value = 0;
+    long long offset = 0; // 当前字符在文件中的偏移
+    long long numberStart = 0; // 当前数字（含负号）的起始偏移
+    bool inNumber = false, negative = false;
+    bool ok = true;
+
+    auto finishNumber = [&]() {
+        chunk->push_back(static_cast<int>(negative ? -value : value));
+        if (chunk->size() == chunkSize) {
+            broadcast(queues, chunk);
+            chunk = make_shared<vector<int>>();
+            chunk->reserve(chunkSize);
+        }
+        value = 0;
+        inNumber = negative = false;
+    };
+
+    size_t n;
+    while (ok && (n = fread(buffer.data(), 1, buffer.size(), fp)) > 0) {
+        for (size_t i = 0; i < n; ++i, ++offset) {
+            char c = buffer[i];
+            if (c >= '0' && c <= '9') {
+                if (!inNumber && !negative)
+                    numberStart = offset;
+                value = value * 10 + (c - '0');
+                inNumber = true;
+                // 负数允许到 INT_MIN
+                if (value > static_cast<long long>(INT_MAX) + (negative ? 1 : 0)) {
+                    cerr << "Page number out of range at offset " << numberStart << endl;
+                    ok = false;
+                    break;
+                }
+            } else if (c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f') {
+                if (inNumber) {
+                    finishNumber();
+                } else if (negative) {
+                    cerr << "Expected digit after '-' at offset " << offset << endl;
+                    ok = false;
+                    break;
+                }
+            } else if (c == '-' && !inNumber && !negative) {
+                numberStart = offset;
+                negative = true;
+            } else {
+                cerr << "Invalid character '" << c << "' at offset " << offset << endl;
+                ok = false;
+                break;
+            }
+        }
+    }
+    if (ok && negative && !inNumber) {
+        cerr << "Expected digit after '-' at offset " << offset << endl;
+        ok = false;
+    }
+    if (ok && inNumber)
+        finishNumber();
+    if (ok && !chunk->empty())
+        broadcast(queues, chunk);
+
+    if (fp != stdin)
+        fclose(fp);
+    return ok;
+}
+
+// 读取二进制格式序列（连续的 int32 页号）
+#ifndef _WIN32
+// POSIX：通过 mmap 按块拷贝，已拷贝完的整页立即释放，驻留内存不随文件大小增长
+bool readBinaryTrace(const string& path, size_t chunkSize, vector<unique_ptr<BoundedQueue>>& queues) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        cerr << "Cannot open " << path << endl;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        cerr << "Cannot stat " << path << endl;
+        close(fd);
+        return false;
+    }
+    if (st.st_size % sizeof(int32_t) != 0) {
+        cerr << "Malformed binary trace " << path << ": size " << st.st_size
+             << " is not a multiple of " << sizeof(int32_t) << endl;
+        close(fd);
+        return false;
+    }
+    size_t count = st.st_size / sizeof(int32_t);
+    if (count == 0) {
+        close(fd);
+        return true;
+    }
+
+    void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        cerr << "Cannot mmap " << path << endl;
+        return false;
+    }
+    madvise(addr, st.st_size, MADV_SEQUENTIAL);
+
+    const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const int32_t* data = static_cast<const int32_t*>(addr);
+    char* base = static_cast<char*>(addr);
+    size_t released = 0; // 已释放的字节数（页对齐）
+    for (size_t offset = 0; offset < count; offset += chunkSize) {
+        size_t len = min(chunkSize, count - offset);
+        broadcast(queues, make_shared<vector<int>>(data + offset, data + offset + len));
+
+        // 释放已拷贝完的整页
+        size_t done = (offset + len) * sizeof(int32_t) / pageSize * pageSize;
+        if (done > released) {
+            madvise(base + released, done - released, MADV_DONTNEED);
+            released = done;
+        }
+    }
+
+    munmap(addr, st.st_size);
+    return true;
+}
+#else
+// Windows：没有 mmap，用 fread 按块读取
+bool readBinaryTrace(const string& path, size_t chunkSize, vector<unique_ptr<BoundedQueue>>& queues) {
+    FILE* fp = fopen(path.c_str(), "rb");
+    if (!fp) {
+        cerr << "Cannot open " << path << endl;
+        return false;
+    }
+
+    vector<int32_t> buffer(chunkSize);
+    long long total = 0; // 已读取的字节数
+    bool ok = true;
+    size_t n;
+    while ((n = fread(buffer.data(), 1, chunkSize * sizeof(int32_t), fp)) > 0) {
+        total += n;
+        if (n % sizeof(int32_t) != 0) {
+            // 只有文件末尾会读到不足一块的数据
+            cerr << "Malformed binary trace " << path << ": size " << total
+                 << " is not a multiple of " << sizeof(int32_t) << endl;
+            ok = false;
+            break;
+        }
+        size_t len = n / sizeof(int32_t);
+        broadcast(queues, make_shared<vector<int>>(buffer.begin(), buffer.begin() + len));
+    }
+
+    fclose(fp);
+    return ok;
+}
+#endif
+
+// 多个模拟线程共用标准输出，采样行整行加锁输出
+mutex outputMutex;
+
+// 输出一条采样：时刻 time 的驻留集大小，以及最近 length 次访问的缺页率
+void printSample(const SimConfig& config, long long time, size_t resident, long long faults, long long length) {
+    ostringstream line;
+    line << config.policy << " (" << paramName(config) << "=" << config.param << ") t=" << time
+         << ": Resident set: " << resident
+         << ", Page fault rate: " << fixed << setprecision(2)
+         << (static_cast<double>(faults) / length * 100) << "%\n";
+    lock_guard<mutex> lock(outputMutex);
+    cout << line.str() << flush;
+}
+
+// 模拟线程：从自己的队列中取块并逐页模拟，每 sampleInterval 次访问输出一次采样（0 表示不采样）
+void runSimulator(SimConfig& config, BoundedQueue& queue, long long sampleInterval) {
+    unique_ptr<PageSimulator> sim = makeSimulator(config);
+    long long intervalFaults = 0;
+    size_t resident = 0;
+    while (Chunk chunk = queue.pop()) {
+        for (int page : *chunk) {
+            if (sim->access(page)) {
+                config.pageFaults++;
+                intervalFaults++;
+            }
+            config.references++;
+
+            resident = sim->residentSize();
+            config.residentSum += resident;
+            config.residentMax = max(config.residentMax, resident);
+            if (sampleInterval > 0 && config.references % sampleInterval == 0) {
+                printSample(config, config.references, resident, intervalFaults, sampleInterval);
+                intervalFaults = 0;
+            }
+        }
+    }
+
+    // 最后不足一个采样间隔的部分
+    long long remainder = sampleInterval > 0 ? config.references % sampleInterval : 0;
+    if (remainder > 0)
+        printSample(config, config.references, resident, intervalFaults, remainder);
+}
+
+void printUsage(const char* prog) {
+    cerr << "Usage: " << prog << " [--binary] [--chunk N] [--queue N] [--sample N] <trace|-> <policy:param>...\n"
+         << "  policy: fifo:frameCount | lru:frameCount | ws:window | pff:threshold\n"
+         << "  --sample N: report resident set size and fault rate every N references\n"
+         << "  e.g. " << prog << " trace.txt fifo:3 lru:3 ws:5 pff:4\n";
+}
+
+const long long MAX_CHUNK_SIZE = 1 << 22;   // 每块最多 4M 个页面（16 MB）
+const long long MAX_QUEUE_CAPACITY = 1024;
+
+// 流式模式入口，返回进程退出码
+int streamMain(int argc, char* argv[]) {
+    bool binary = false;
+    size_t chunkSize = 4096;  // 每块页面数
+    size_t queueCapacity = 8; // 每个模拟线程队列中最多缓存的块数
+    long long sampleInterval = 0; // 采样间隔（访问次数），0 表示不采样
+    string path;
+    vector<SimConfig> configs;
+
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--binary") {
+            binary = true;
+        } else if ((arg == "--chunk" || arg == "--queue" || arg == "--sample") && i + 1 < argc) {
+            // 每块页面数与队列深度设上限，避免一次分配过多内存
+            long long maxValue = (arg == "--chunk") ? MAX_CHUNK_SIZE
+                               : (arg == "--queue") ? MAX_QUEUE_CAPACITY : LLONG_MAX;
+            long long v;
+            if (!parsePositive(argv[++i], maxValue, v)) {
+                cerr << "Invalid value for " << arg << ": " << argv[i]
+                     << " (expected 1.." << maxValue << ")" << endl;
+                printUsage(argv[0]);
+                return 1;
+            }
+            if (arg == "--sample")
+                sampleInterval = v;
+            else
+                (arg == "--chunk" ? chunkSize : queueCapacity) = static_cast<size_t>(v);
+        } else if (path.empty()) {
+            path = arg;
+        } else {
+            SimConfig config;
+            if (!parseConfig(arg, config)) {
+                cerr << "Invalid configuration: " << arg << endl;
+                printUsage(argv[0]);
+                return 1;
+            }
+            configs.push_back(config);
+        }
+    }
+    if (path.empty() || configs.empty()) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    if (binary && path == "-") {
+        cerr << "Binary traces must be read from a file" << endl;
+        return 1;
+    }
+
+    vector<unique_ptr<BoundedQueue>> queues;
+    vector<thread> workers;
+    for (size_t i = 0; i < configs.size(); ++i)
+        queues.emplace_back(new BoundedQueue(queueCapacity));
+    for (size_t i = 0; i < configs.size(); ++i)
+        workers.emplace_back(runSimulator, ref(configs[i]), ref(*queues[i]), sampleInterval);
+
+    bool ok = binary ? readBinaryTrace(path, chunkSize, queues)
+                     : readTextTrace(path, chunkSize, queues);
+    for (auto& q : queues)
+        q->close();
+    for (auto& w : workers)
+        w.join();
+    if (!ok)
+        return 1;
+
+    // 输出每组配置的缺页总数&缺页中断率，以及驻留集大小
+    for (const auto& c : configs) {
+        double faultRate = c.references ? static_cast<double>(c.pageFaults) / c.references : 0.0;
+        double residentAvg = c.references ? static_cast<double>(c.residentSum) / c.references : 0.0;
+        cout << c.policy << " (" << paramName(c) << "=" << c.param << "): References: " << c.references
+             << ", Total page faults: " << c.pageFaults
+             << ", Page fault rate: " << fixed << setprecision(2) << (faultRate * 100) << "%"
+             << ", Resident set: avg " << residentAvg << ", max " << c.residentMax << "\n";
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    // 带参数运行时进入流式模式
+    if (argc > 1)
+        return streamMain(argc, argv);
+
     // 输入页面序列
     // cout << "输入页面序列（用空格分隔）：";
     cout << "Enter the sequence of pages (separated by spaces): ";